@@ -0,0 +1,338 @@
+// All pairs minimum cut
+// Bourantas Konstantinos
+
+//Client and load generator for the min-cut query server (server.cpp).
+//
+//usage: gh_client SOCKET_PATH pair S T
+//       gh_client SOCKET_PATH batch S T [S T ...]
+//       gh_client SOCKET_PATH stats
+//       gh_client SOCKET_PATH load NUM_NODES REQUESTS [DEPTH] [BATCH]
+//
+//The load mode sends REQUESTS random queries of BATCH pairs each, keeping up to DEPTH requests in flight on
+//one connection, and reports the throughput and the p50/p99 round trip latency.
+
+//==================================================================================================================================
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <cstring>
+#include <climits>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <chrono>
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <errno.h>
+
+#include "protocol.h"
+
+//==================================================================================================================================
+//append one request with count (s, t) pairs to buf
+void put_request(std::vector<char> &buf, uint32_t op, const std::vector<uint32_t> &pairs)
+{
+    gh_request_header h = {op, (uint32_t)(pairs.size() / 2)};
+    size_t pos = buf.size();
+
+    buf.resize(pos + sizeof(h) + pairs.size() * sizeof(uint32_t));
+    memcpy(&buf[pos], &h, sizeof(h));
+
+    if (!pairs.empty())
+        memcpy(&buf[pos + sizeof(h)], pairs.data(), pairs.size() * sizeof(uint32_t));
+}
+
+//==================================================================================================================================
+//send one request with count (s, t) pairs
+bool send_request(int fd, uint32_t op, const std::vector<uint32_t> &pairs)
+{
+    std::vector<char> buf;
+    put_request(buf, op, pairs);
+
+    return write_full(fd, buf.data(), buf.size());
+}
+
+//==================================================================================================================================
+//read one response, returns false if the connection broke
+bool read_response(int fd, gh_response_header &h, std::vector<uint32_t> &values)
+{
+    if (!read_full(fd, &h, sizeof(h)))
+        return false;
+
+    values.resize(h.count);
+
+    return h.count == 0 || read_full(fd, values.data(), (size_t)h.count * sizeof(uint32_t));
+}
+
+//==================================================================================================================================
+//send one request and print its answer
+int run_query(int fd, uint32_t op, const std::vector<uint32_t> &pairs)
+{
+    gh_response_header h;
+    std::vector<uint32_t> values;
+
+    if (!send_request(fd, op, pairs) || !read_response(fd, h, values))
+    {
+        std::cout << "\033[1;31m[-]Connection to the server failed!\033[0m\n";
+        return 1;
+    }
+
+    if (h.status != GH_STATUS_OK)
+    {
+        std::cout << "\033[1;31m[-]Server answered with status " << h.status << "\033[0m\n";
+        return 1;
+    }
+
+    if (op == GH_OP_STATS)
+    {
+        if (h.count != GH_STATS_VALUES)
+        {
+            std::cout << "\033[1;31m[-]Server sent " << h.count << " stats values, expected " << GH_STATS_VALUES << "\033[0m\n";
+            return 1;
+        }
+
+        std::cout << "Requests served: " << values[0] << "\np50 latency: " << values[1] << "ns\np99 latency: " << values[2] << "ns\n";
+        return 0;
+    }
+
+    for (uint32_t i = 0; i < h.count; i++)
+        printf("[%u] - [%u] has min-cut: %u\n", pairs[2 * i], pairs[2 * i + 1], values[i]);
+
+    return 0;
+}
+
+//==================================================================================================================================
+//pipelined load generator. The socket is non-blocking and polled for both directions, so answers are read
+//while requests are still being written and neither side can end up blocked writing to the other.
+int run_load(int fd, int num_nodes, int num_requests, int depth, int batch)
+{
+    typedef std::chrono::steady_clock clock_type;
+
+    std::deque<clock_type::time_point> in_flight;
+    std::vector<unsigned long long> latencies;
+    std::vector<uint32_t> pairs(2 * batch);
+    std::vector<char> out, in(64 * 1024);
+    size_t out_sent = 0, filled = 0;
+
+    int sent = 0, received = 0, errors = 0;
+    uint32_t op = (batch == 1) ? GH_OP_PAIR : GH_OP_BATCH;
+
+    int flags = fcntl(fd, F_GETFL, 0);
+
+    if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0)
+    {
+        std::cout << "\033[1;31m[-]Could not make the socket non-blocking!\033[0m\n";
+        return 1;
+    }
+
+    latencies.reserve(num_requests);
+    srand(time(0));
+
+    clock_type::time_point begin = clock_type::now();
+
+    while (received < num_requests)
+    {
+        //fill the pipeline, a request counts as in flight from the moment it is queued
+        while (sent < num_requests && (int)in_flight.size() < depth)
+        {
+            for (int i = 0; i < 2 * batch; i++)
+                pairs[i] = rand() % num_nodes;
+
+            put_request(out, op, pairs);
+            in_flight.push_back(clock_type::now());
+            sent++;
+        }
+
+        struct pollfd p = {fd, POLLIN, 0};
+
+        if (out_sent < out.size())
+            p.events |= POLLOUT;
+
+        if (poll(&p, 1, -1) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            std::cout << "\033[1;31m[-]poll failed!\033[0m\n";
+            return 1;
+        }
+
+        //write what the socket takes
+        while (out_sent < out.size())
+        {
+            ssize_t n = write(fd, &out[out_sent], out.size() - out_sent);
+
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                break;
+            if (n <= 0)
+            {
+                std::cout << "\033[1;31m[-]Connection to the server failed!\033[0m\n";
+                return 1;
+            }
+
+            out_sent += n;
+        }
+
+        if (out_sent == out.size())
+        {
+            out.clear();
+            out_sent = 0;
+        }
+
+        if (!(p.revents & (POLLIN | POLLHUP | POLLERR)))
+            continue;
+
+        if (filled == in.size())
+            in.resize(in.size() * 2);
+
+        ssize_t got = read(fd, &in[filled], in.size() - filled);
+
+        if (got < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK))
+            continue;
+        if (got <= 0)
+        {
+            std::cout << "\033[1;31m[-]Connection to the server failed!\033[0m\n";
+            return 1;
+        }
+
+        filled += got;
+
+        //take every complete answer, they come back in request order
+        size_t pos = 0;
+
+        while (filled - pos >= sizeof(gh_response_header))
+        {
+            gh_response_header h;
+            memcpy(&h, &in[pos], sizeof(h));
+
+            size_t need = sizeof(h) + (size_t)h.count * sizeof(uint32_t);
+
+            if (filled - pos < need)
+            {
+                if (need > in.size())
+                    in.resize(need);
+                break;
+            }
+
+            if (in_flight.empty())
+            {
+                std::cout << "\033[1;31m[-]Server sent an answer nobody asked for!\033[0m\n";
+                return 1;
+            }
+
+            latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now() - in_flight.front()).count());
+            in_flight.pop_front();
+
+            if (h.status != GH_STATUS_OK)
+                errors++;
+            received++;
+
+            pos += need;
+        }
+
+        if (pos > 0)
+        {
+            memmove(&in[0], &in[pos], filled - pos);
+            filled -= pos;
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(clock_type::now() - begin).count();
+
+    std::sort(latencies.begin(), latencies.end());
+
+    std::cout << "Requests: " << num_requests << " (" << batch << " pairs each, depth " << depth << ")\n";
+    std::cout << "Errors: " << errors << "\n";
+    std::cout << "Time elapsed: " << seconds << "s.\n";
+    std::cout << "Throughput: " << num_requests / seconds << " requests/s, " << (double)num_requests * batch / seconds << " pairs/s\n";
+
+    if (!latencies.empty())
+    {
+        std::cout << "p50 latency: " << latencies[latencies.size() / 2] / 1000.0 << "us\n";
+        std::cout << "p99 latency: " << latencies[std::min(latencies.size() - 1, latencies.size() * 99 / 100)] / 1000.0 << "us\n";
+    }
+
+    return errors > 0;
+}
+
+//==================================================================================================================================
+void print_usage()
+{
+    std::cout << "usage: gh_client SOCKET_PATH pair S T\n"
+              << "       gh_client SOCKET_PATH batch S T [S T ...]\n"
+              << "       gh_client SOCKET_PATH stats\n"
+              << "       gh_client SOCKET_PATH load NUM_NODES REQUESTS [DEPTH] [BATCH]\n";
+}
+
+//==================================================================================================================================
+//Main function
+int main(int argc, char *argv[])
+{
+    if (argc < 3)
+    {
+        print_usage();
+        return 1;
+    }
+
+    const char *mode = argv[2];
+    std::vector<uint32_t> pairs;
+    bool numbers_valid = true;
+
+    //node indices must fit the protocol's 32 bits and the load counts an int, anything else is rejected
+    unsigned long long limit = (strcmp(mode, "load") == 0) ? INT_MAX : UINT32_MAX;
+
+    for (int i = 3; i < argc; i++)
+    {
+        char *end;
+        errno = 0;
+        unsigned long long value = strtoull(argv[i], &end, 10);
+
+        if (errno != 0 || *end != '\0' || end == argv[i] || argv[i][0] == '-' || value > limit)
+            numbers_valid = false;
+
+        pairs.push_back(value);
+    }
+
+    bool valid = numbers_valid &&
+                 ((strcmp(mode, "pair") == 0 && pairs.size() == 2) ||
+                  (strcmp(mode, "batch") == 0 && pairs.size() >= 2 && pairs.size() % 2 == 0) ||
+                  (strcmp(mode, "stats") == 0 && pairs.empty()) ||
+                  (strcmp(mode, "load") == 0 && pairs.size() >= 2 && pairs.size() <= 4 && pairs[0] > 0 && pairs[1] > 0));
+
+    if (!valid)
+    {
+        print_usage();
+        return 1;
+    }
+
+    int fd = connect_unix_socket(argv[1]);
+
+    if (fd < 0)
+    {
+        std::cout << "\033[1;31m[-]Could not connect to " << argv[1] << "\033[0m\n";
+        return 1;
+    }
+
+    int result;
+
+    if (strcmp(mode, "pair") == 0)
+        result = run_query(fd, GH_OP_PAIR, pairs);
+    else if (strcmp(mode, "batch") == 0)
+        result = run_query(fd, GH_OP_BATCH, pairs);
+    else if (strcmp(mode, "stats") == 0)
+        result = run_query(fd, GH_OP_STATS, pairs);
+    else
+    {
+        int depth = pairs.size() > 2 ? std::max(1u, pairs[2]) : 16;
+        int batch = pairs.size() > 3 ? std::min(std::max(1u, pairs[3]), GH_MAX_BATCH) : 1;
+
+        result = run_load(fd, pairs[0], pairs[1], depth, batch);
+    }
+
+    close(fd);
+
+    return result;
+}
@@ -0,0 +1,247 @@
+// All pairs minimum cut
+// Bourantas Konstantinos
+
+//Flat Gomory-Hu cut tree for answering min-cut queries (see cut_tree.h).
+
+#include <LEDA/graph/graph.h>
+
+#include <iostream>
+#include <fstream>
+#include <climits>
+#include <vector>
+
+#include "cut_tree.h"
+
+using namespace leda;
+
+//==================================================================================================================================
+//build the query tree from the graph returned by create_gomory_hu_tree
+bool cut_tree_from_graph(cut_tree &T, node v[], edge_array<int> &capacity, const graph &G, int num_nodes)
+{
+    node_array<int> index(G, -1);
+
+    for (int i = 0; i < num_nodes; i++)
+        index[v[i]] = i;
+
+    std::vector<int> parent(num_nodes, -1);
+    std::vector<int> weight(num_nodes, 0);
+    std::vector<bool> visited(num_nodes, false);
+    std::vector<int> Q(num_nodes);
+
+    //the cut tree has no edge between components of a disconnected graph, so it can be a forest
+    for (int root = 0; root < num_nodes; root++)
+    {
+        if (visited[root])
+            continue;
+
+        int head = 0, tail = 0;
+        Q[tail++] = root;
+        visited[root] = true;
+
+        while (head < tail)
+        {
+            node u = v[Q[head++]];
+            edge e;
+
+            forall_adj_edges(e, u)
+            {
+                int j = index[G.target(e)];
+
+                if (j < 0 || visited[j])
+                    continue;
+
+                visited[j] = true;
+                parent[j] = index[u];
+                weight[j] = capacity[e];
+                Q[tail++] = j;
+            }
+        }
+    }
+
+    return cut_tree_from_parents(T, parent, weight);
+}
+
+//==================================================================================================================================
+//build depths, components and the binary lifting tables from parent/weight arrays
+bool cut_tree_from_parents(cut_tree &T, const std::vector<int> &parent, const std::vector<int> &weight)
+{
+    int n = parent.size();
+
+    T.num_nodes = n;
+    T.parent = parent;
+    T.weight = weight;
+    T.depth.assign(n, -1);
+    T.component.assign(n, -1);
+
+    //children lists in flat form, start[i]..start[i+1] are the children of i
+    std::vector<int> start(n + 1, 0), children(n);
+
+    for (int i = 0; i < n; i++)
+    {
+        if (parent[i] < -1 || parent[i] >= n)
+            return false;
+        if (parent[i] >= 0)
+            start[parent[i] + 1]++;
+    }
+
+    for (int i = 0; i < n; i++)
+        start[i + 1] += start[i];
+
+    std::vector<int> fill(start.begin(), start.end() - 1);
+
+    for (int i = 0; i < n; i++)
+    {
+        if (parent[i] >= 0)
+            children[fill[parent[i]]++] = i;
+    }
+
+    //walk down from every root, nodes never reached sit on a cycle
+    std::vector<int> Q(n);
+    int head = 0, tail = 0;
+
+    for (int i = 0; i < n; i++)
+    {
+        if (parent[i] == -1)
+        {
+            T.depth[i] = 0;
+            T.component[i] = i;
+            Q[tail++] = i;
+        }
+    }
+
+    while (head < tail)
+    {
+        int u = Q[head++];
+
+        for (int k = start[u]; k < start[u + 1]; k++)
+        {
+            int c = children[k];
+            T.depth[c] = T.depth[u] + 1;
+            T.component[c] = T.component[u];
+            Q[tail++] = c;
+        }
+    }
+
+    if (tail != n)
+        return false;
+
+    T.levels = 1;
+    while ((1 << T.levels) < n)
+        T.levels++;
+
+    T.up.assign((size_t)T.levels * n, 0);
+    T.up_min.assign((size_t)T.levels * n, INT_MAX);
+
+    //a root is its own ancestor so lifting past it stays in place
+    for (int i = 0; i < n; i++)
+    {
+        T.up[i] = (parent[i] >= 0) ? parent[i] : i;
+        T.up_min[i] = (parent[i] >= 0) ? weight[i] : INT_MAX;
+    }
+
+    for (int k = 1; k < T.levels; k++)
+    {
+        int *up = &T.up[(size_t)k * n];
+        int *up_min = &T.up_min[(size_t)k * n];
+        const int *prev = &T.up[(size_t)(k - 1) * n];
+        const int *prev_min = &T.up_min[(size_t)(k - 1) * n];
+
+        for (int i = 0; i < n; i++)
+        {
+            up[i] = prev[prev[i]];
+            up_min[i] = std::min(prev_min[i], prev_min[prev[i]]);
+        }
+    }
+
+    return true;
+}
+
+//==================================================================================================================================
+//write the tree to a text file
+bool save_cut_tree(const cut_tree &T, const char *path)
+{
+    std::ofstream ofs(path);
+
+    if (!ofs)
+        return false;
+
+    ofs << T.num_nodes << "\n";
+
+    for (int i = 0; i < T.num_nodes; i++)
+        ofs << i << " " << T.parent[i] << " " << T.weight[i] << "\n";
+
+    return (bool)ofs;
+}
+
+//==================================================================================================================================
+//read a tree written by save_cut_tree
+bool load_cut_tree(cut_tree &T, const char *path)
+{
+    std::ifstream ifs(path);
+    int num_nodes = 0;
+
+    if (!(ifs >> num_nodes) || num_nodes <= 0)
+        return false;
+
+    std::vector<int> parent(num_nodes, -1);
+    std::vector<int> weight(num_nodes, 0);
+    std::vector<bool> seen(num_nodes, false);
+
+    for (int k = 0; k < num_nodes; k++)
+    {
+        int i, p, w;
+
+        if (!(ifs >> i >> p >> w) || i < 0 || i >= num_nodes || seen[i])
+            return false;
+
+        seen[i] = true;
+        parent[i] = p;
+        weight[i] = w;
+    }
+
+    return cut_tree_from_parents(T, parent, weight);
+}
+
+//==================================================================================================================================
+//min-cut between s and t is the smallest capacity on their tree path
+int query_min_cut(const cut_tree &T, int s, int t)
+{
+    if (s == t || T.component[s] != T.component[t])
+        return 0;
+
+    int n = T.num_nodes;
+    int min_cut = INT_MAX;
+
+    if (T.depth[s] < T.depth[t])
+        std::swap(s, t);
+
+    //lift s to the depth of t
+    int diff = T.depth[s] - T.depth[t];
+
+    for (int k = 0; diff > 0; k++, diff >>= 1)
+    {
+        if (diff & 1)
+        {
+            min_cut = std::min(min_cut, T.up_min[(size_t)k * n + s]);
+            s = T.up[(size_t)k * n + s];
+        }
+    }
+
+    if (s == t)
+        return min_cut;
+
+    //lift both until they are right below their common ancestor
+    for (int k = T.levels - 1; k >= 0; k--)
+    {
+        size_t base = (size_t)k * n;
+
+        if (T.up[base + s] != T.up[base + t])
+        {
+            min_cut = std::min(min_cut, std::min(T.up_min[base + s], T.up_min[base + t]));
+            s = T.up[base + s];
+            t = T.up[base + t];
+        }
+    }
+
+    return std::min(min_cut, std::min(T.up_min[s], T.up_min[t]));
+}
@@ -0,0 +1,50 @@
+// All pairs minimum cut
+// Bourantas Konstantinos
+
+//Flat, read-only form of a Gomory-Hu cut tree used to answer min-cut queries without touching LEDA.
+//The min-cut between s and t is the smallest capacity on the tree path between them, which we find
+//in O(log n) with binary lifting.
+
+#ifndef GOMORYHU_CUT_TREE_H
+#define GOMORYHU_CUT_TREE_H
+
+#include <LEDA/graph/graph.h>
+
+#include <vector>
+
+using namespace leda;
+
+//==================================================================================================================================
+struct cut_tree
+{
+    int num_nodes;
+    int levels;
+
+    std::vector<int> parent;    //parent of every node, -1 for a root
+    std::vector<int> weight;    //capacity of the edge to the parent
+    std::vector<int> depth;     //distance from the root
+    std::vector<int> component; //root of the tree the node belongs to
+
+    //up[k * num_nodes + i] is the 2^k-th ancestor of i and up_min the smallest capacity on the way there
+    std::vector<int> up;
+    std::vector<int> up_min;
+};
+
+//==================================================================================================================================
+//build the query tree from the graph returned by create_gomory_hu_tree. Node i is v[i]
+bool cut_tree_from_graph(cut_tree &T, node v[], edge_array<int> &capacity, const graph &G, int num_nodes);
+//==================================================================================================================================
+//build the query tree from parent/weight arrays, returns false if they do not form a forest
+bool cut_tree_from_parents(cut_tree &T, const std::vector<int> &parent, const std::vector<int> &weight);
+//==================================================================================================================================
+//write the tree to a text file, one "node parent capacity" line per node
+bool save_cut_tree(const cut_tree &T, const char *path);
+//==================================================================================================================================
+//read a tree written by save_cut_tree
+bool load_cut_tree(cut_tree &T, const char *path);
+//==================================================================================================================================
+//min-cut between nodes s and t, 0 if they are the same node or in different components
+int query_min_cut(const cut_tree &T, int s, int t);
+//==================================================================================================================================
+
+#endif
@@ -19,6 +19,7 @@
 #include <iostream>
 #include <ctime>
 #include <fstream>
+#include <vector>
 
 #include "setup.h"
 
@@ -157,25 +158,90 @@ int main()
     //Time this---------------------------------------------------------------------------------------------
     //gomory hu tree construction
 
-    double time_elapsed_gomoryhu = 0;
-    edge_array<int> new_capacity(G, 0);
+    //build the tree with ORDER_NONE only, or set compare_orders to also build it with ORDER_BFS and
+    //ORDER_DEGREE. Every order is timed and checked against leda
+    bool compare_orders = false;
 
-    //find all pairs mincut with gomoryhu tree
-    begin = clock();
+    int orders[] = {ORDER_NONE, ORDER_BFS, ORDER_DEGREE};
+    const char *order_names[] = {"none", "bfs", "degree"};
+    int num_orders = compare_orders ? 3 : 1;
 
-    edge_array<edge> new_rev_edge = create_gomory_hu_tree(color, v, rev_edge, capacity, new_capacity, G, num_nodes);
+    double time_elapsed_tree[3], time_elapsed_gomoryhu[3];
+    int wrong_calculations[3];
     int max_flow_mine[num_nodes * num_nodes];
 
-    find_mincut_for_all_pairs(num_nodes, max_flow_mine, color, v, new_rev_edge, new_capacity, G);
+    //save the arcs and their capacities, create_gomory_hu_tree replaces the edges of G with the cut tree
+    node_array<int> node_index(G, -1);
+    for (i = 0; i < num_nodes; i++)
+        node_index[v[i]] = i;
 
-    end = clock();
-    time_elapsed_gomoryhu = double(end - begin) / CLOCKS_PER_SEC;
+    std::vector<int> arc_source, arc_target, arc_capacity;
+    edge e;
 
-    std::cout << "Time elapsed for gomoryhu: " << time_elapsed_gomoryhu << "s.\n";
-    //---------------------------------------------------------------------------------------------
+    if (compare_orders)
+    {
+        forall_edges(e, G)
+        {
+            arc_source.push_back(node_index[G.source(e)]);
+            arc_target.push_back(node_index[G.target(e)]);
+            arc_capacity.push_back(capacity[e]);
+        }
+    }
+
+    for (int k = 0; k < num_orders; k++)
+    {
+        //put the input graph back in its original arc order
+        if (k > 0)
+        {
+            G.del_all_edges();
+
+            for (int a = 0; a < (int)arc_source.size(); a++)
+                G.new_edge(v[arc_source[a]], v[arc_target[a]]);
+
+            capacity.init(G, 0);
+            int a = 0;
+
+            forall_edges(e, G) capacity[e] = arc_capacity[a++];
+
+            rev_edge = save_rev_edge(capacity, G);
+        }
+
+        if (compare_orders)
+            std::cout << "\n==============================\nNode order: " << order_names[k] << "\n==============================\n";
 
-    //check if the results are correct
-    all_pair_mincut_checker(num_nodes, max_flow_mine, max_flow_leda);
+        edge_array<int> new_capacity(G, 0);
+
+        //find all pairs mincut with gomoryhu tree
+        begin = clock();
+
+        edge_array<edge> new_rev_edge = create_gomory_hu_tree(color, v, rev_edge, capacity, new_capacity, G, num_nodes, orders[k]);
+
+        clock_t tree_end = clock();
+
+        find_mincut_for_all_pairs(num_nodes, max_flow_mine, color, v, new_rev_edge, new_capacity, G);
+
+        end = clock();
+        time_elapsed_tree[k] = double(tree_end - begin) / CLOCKS_PER_SEC;
+        time_elapsed_gomoryhu[k] = double(end - begin) / CLOCKS_PER_SEC;
+
+        std::cout << "Time elapsed for gomoryhu: " << time_elapsed_gomoryhu[k] << "s.\n";
+        //---------------------------------------------------------------------------------------------
+
+        //check if the results are correct
+        wrong_calculations[k] = all_pair_mincut_checker(num_nodes, max_flow_mine, max_flow_leda);
+    }
+
+    if (compare_orders)
+    {
+        std::cout << "\n\n==============================\nSummary\n==============================\n";
+        std::cout << "leda: " << time_elapsed_leda << "s\n";
+
+        for (int k = 0; k < num_orders; k++)
+        {
+            std::cout << "gomoryhu (" << order_names[k] << "): " << time_elapsed_gomoryhu[k] << "s, tree construction " << time_elapsed_tree[k]
+                      << "s, wrong calculations: " << wrong_calculations[k] << "\n";
+        }
+    }
 
     //Write results to a file
     //std::ofstream ofs;
@@ -0,0 +1,86 @@
+// All pairs minimum cut
+// Bourantas Konstantinos
+
+//Socket helpers shared by the min-cut query server and its client.
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+
+#include "protocol.h"
+
+//==================================================================================================================================
+//read exactly len bytes from fd
+bool read_full(int fd, void *buf, size_t len)
+{
+    char *p = (char *)buf;
+
+    while (len > 0)
+    {
+        ssize_t got = read(fd, p, len);
+
+        if (got < 0 && errno == EINTR)
+            continue;
+
+        //error or the other side closed the connection
+        if (got <= 0)
+            return false;
+
+        p += got;
+        len -= got;
+    }
+
+    return true;
+}
+
+//==================================================================================================================================
+//write exactly len bytes to fd
+bool write_full(int fd, const void *buf, size_t len)
+{
+    const char *p = (const char *)buf;
+
+    while (len > 0)
+    {
+        ssize_t sent = write(fd, p, len);
+
+        if (sent < 0 && errno == EINTR)
+            continue;
+
+        if (sent <= 0)
+            return false;
+
+        p += sent;
+        len -= sent;
+    }
+
+    return true;
+}
+
+//==================================================================================================================================
+//connect to the server's Unix socket
+int connect_unix_socket(const char *path)
+{
+    struct sockaddr_un addr;
+
+    if (strlen(path) >= sizeof(addr.sun_path))
+        return -1;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (fd < 0)
+        return -1;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
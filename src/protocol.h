@@ -0,0 +1,61 @@
+// All pairs minimum cut
+// Bourantas Konstantinos
+
+//Binary request/response protocol spoken by the min-cut query server (server.cpp) and its client (client.cpp).
+//Every field is a 32 bit unsigned integer in host byte order, the server only listens on a Unix domain socket.
+//
+//request : [op][count] followed by count (s, t) node index pairs
+//response: [status][count] followed by count values
+//
+//Requests may be pipelined, responses are always sent back in request order.
+
+#ifndef GOMORYHU_PROTOCOL_H
+#define GOMORYHU_PROTOCOL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+//==================================================================================================================================
+//request opcodes
+const uint32_t GH_OP_PAIR = 1;  //min-cut of one pair, count must be 1
+const uint32_t GH_OP_BATCH = 2; //min-cut of count pairs, answered with count values in the same order
+const uint32_t GH_OP_STATS = 3; //server latency stats, count must be 0. Answer is [requests][p50 ns][p99 ns]
+
+//The stats latency runs from the read that received a request until its answer is fully written, all requests
+//answered from the same read share one value. The request count saturates at UINT32_MAX, latencies at ~4.29s.
+
+//response status codes
+const uint32_t GH_STATUS_OK = 0;
+const uint32_t GH_STATUS_BAD_OP = 1;    //unknown opcode or wrong count for the opcode
+const uint32_t GH_STATUS_BAD_NODE = 2;  //a node index is out of range
+const uint32_t GH_STATUS_TOO_LARGE = 3; //count is above GH_MAX_BATCH, the server closes the connection
+
+//largest number of pairs accepted in one request
+const uint32_t GH_MAX_BATCH = 65536;
+
+const uint32_t GH_STATS_VALUES = 3;
+
+struct gh_request_header
+{
+    uint32_t op;
+    uint32_t count;
+};
+
+struct gh_response_header
+{
+    uint32_t status;
+    uint32_t count;
+};
+
+//==================================================================================================================================
+//read exactly len bytes from fd, returns false on error or end of stream
+bool read_full(int fd, void *buf, size_t len);
+//==================================================================================================================================
+//write exactly len bytes to fd, returns false on error
+bool write_full(int fd, const void *buf, size_t len);
+//==================================================================================================================================
+//open a stream connection to the Unix socket at path, returns -1 on error
+int connect_unix_socket(const char *path);
+//==================================================================================================================================
+
+#endif
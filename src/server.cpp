@@ -0,0 +1,666 @@
+// All pairs minimum cut
+// Bourantas Konstantinos
+
+//Long running min-cut query server. The Gomory-Hu tree is built once (or loaded from a file saved by an
+//earlier run) and pair/batch min-cut queries are answered over a Unix domain socket using the binary
+//protocol described in protocol.h. Connections are spread over a pool of reader threads that each poll their
+//non-blocking connections. Every request is timed from the read that brought it in until its answer is
+//written, and the p50/p99 of that latency can be asked for with GH_OP_STATS or is printed on shutdown.
+//
+//usage: gh_server SOCKET_PATH (--load FILE | --generate NODES EDGES) [--order none|bfs|degree] [--save FILE] [--threads N]
+
+//==================================================================================================================================
+#include <LEDA/graph/graph.h>
+#include <LEDA/system/basic.h>
+
+#include <iostream>
+#include <ctime>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include "setup.h"
+#include "cut_tree.h"
+#include "protocol.h"
+
+using namespace leda;
+
+//==================================================================================================================================
+//latency histogram. Values below 16ns have their own bucket, above that every power of two is split in 16
+//buckets, so a bucket is never wider than 1/16 of its value.
+const int LATENCY_BUCKETS = 61 * 16;
+
+std::atomic<unsigned long long> latency_histogram[LATENCY_BUCKETS];
+std::atomic<bool> stop_requested(false);
+
+//stop reading from a connection while more than this many bytes of answers wait to be sent
+const size_t OUTPUT_LIMIT = 1 << 20;
+
+//requests answered from one read, timed until the last byte of their answers is written
+struct answered_read
+{
+    unsigned long long end; //value of connection::written once the answers are out
+    std::chrono::steady_clock::time_point read_time;
+    unsigned long long requests;
+};
+
+//state of one client connection, owned by a single reader thread
+struct connection
+{
+    int fd;
+    std::vector<char> in; //received bytes, the unfinished request is at the front
+    size_t filled;
+    std::vector<char> out; //answers not written yet start at out_sent
+    size_t out_sent;
+    unsigned long long appended, written; //answer bytes queued and written since the connection opened
+    std::deque<answered_read> timing;
+    bool closing; //close once out is written
+};
+
+//a reader thread and the connections the accepting thread hands to it. A byte on wake_pipe means the inbox has new fds
+struct reader
+{
+    std::thread thread;
+    int wake_pipe[2];
+    std::mutex inbox_mutex;
+    std::vector<int> inbox;
+};
+
+//==================================================================================================================================
+int latency_bucket(unsigned long long ns)
+{
+    if (ns < 16)
+        return ns;
+
+    int b = 63 - __builtin_clzll(ns);
+
+    return (b - 3) * 16 + ((ns >> (b - 4)) & 15);
+}
+
+//==================================================================================================================================
+//lower bound in ns of a histogram bucket
+unsigned long long latency_bucket_value(int bucket)
+{
+    if (bucket < 16)
+        return bucket;
+
+    return (unsigned long long)(16 + bucket % 16) << (bucket / 16 - 1);
+}
+
+//==================================================================================================================================
+//q-th quantile of the recorded latencies in ns
+unsigned long long latency_percentile(double q, unsigned long long &total)
+{
+    unsigned long long counts[LATENCY_BUCKETS];
+    total = 0;
+
+    for (int i = 0; i < LATENCY_BUCKETS; i++)
+    {
+        counts[i] = latency_histogram[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+
+    if (total == 0)
+        return 0;
+
+    unsigned long long rank = (unsigned long long)(q * total);
+    unsigned long long seen = 0;
+
+    if (rank >= total)
+        rank = total - 1;
+
+    for (int i = 0; i < LATENCY_BUCKETS; i++)
+    {
+        seen += counts[i];
+        if (seen > rank)
+            return latency_bucket_value(i);
+    }
+
+    return latency_bucket_value(LATENCY_BUCKETS - 1);
+}
+
+//==================================================================================================================================
+//append a response to the output buffer
+void put_response(std::vector<char> &out, uint32_t status, const uint32_t *values, uint32_t count)
+{
+    gh_response_header h = {status, count};
+    size_t pos = out.size();
+
+    out.resize(pos + sizeof(h) + (size_t)count * sizeof(uint32_t));
+    memcpy(&out[pos], &h, sizeof(h));
+
+    if (count > 0)
+        memcpy(&out[pos + sizeof(h)], values, (size_t)count * sizeof(uint32_t));
+}
+
+//==================================================================================================================================
+//answer one request whose payload of h.count (s, t) pairs starts at payload
+void handle_request(const cut_tree &T, const gh_request_header &h, const char *payload, std::vector<char> &out, std::vector<uint32_t> &values)
+{
+    if (h.op == GH_OP_STATS)
+    {
+        if (h.count != 0)
+        {
+            put_response(out, GH_STATUS_BAD_OP, NULL, 0);
+            return;
+        }
+
+        unsigned long long total;
+        uint32_t stats[GH_STATS_VALUES];
+
+        //the answer is 32 bit, larger values saturate
+        stats[1] = std::min(latency_percentile(0.50, total), (unsigned long long)UINT32_MAX);
+        stats[2] = std::min(latency_percentile(0.99, total), (unsigned long long)UINT32_MAX);
+        stats[0] = std::min(total, (unsigned long long)UINT32_MAX);
+
+        put_response(out, GH_STATUS_OK, stats, GH_STATS_VALUES);
+        return;
+    }
+
+    if ((h.op != GH_OP_PAIR && h.op != GH_OP_BATCH) || (h.op == GH_OP_PAIR && h.count != 1))
+    {
+        put_response(out, GH_STATUS_BAD_OP, NULL, 0);
+        return;
+    }
+
+    values.resize(h.count);
+
+    for (uint32_t i = 0; i < h.count; i++)
+    {
+        uint32_t pair[2];
+        memcpy(pair, payload + (size_t)i * sizeof(pair), sizeof(pair));
+
+        if (pair[0] >= (uint32_t)T.num_nodes || pair[1] >= (uint32_t)T.num_nodes)
+        {
+            put_response(out, GH_STATUS_BAD_NODE, NULL, 0);
+            return;
+        }
+
+        values[i] = query_min_cut(T, pair[0], pair[1]);
+    }
+
+    put_response(out, GH_STATUS_OK, values.data(), h.count);
+}
+
+//==================================================================================================================================
+//make fd non-blocking, returns false on error
+bool set_nonblocking(int fd)
+{
+    int flags = fcntl(fd, F_GETFL, 0);
+
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+//==================================================================================================================================
+//read what is available on a connection and answer every complete request in it.
+//Returns false if the read failed
+bool read_connection(connection &c, const cut_tree &T, std::vector<uint32_t> &values)
+{
+    if (c.filled == c.in.size())
+        c.in.resize(c.in.size() * 2);
+
+    ssize_t got = read(c.fd, &c.in[c.filled], c.in.size() - c.filled);
+
+    if (got < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK))
+        return true;
+    if (got < 0)
+        return false;
+
+    //the client is done sending, close once the answers it is waiting for are written
+    if (got == 0)
+    {
+        c.closing = true;
+        return true;
+    }
+
+    c.filled += got;
+
+    std::chrono::steady_clock::time_point read_time = std::chrono::steady_clock::now();
+    size_t pos = 0;
+    size_t out_before = c.out.size();
+    unsigned long long requests = 0;
+
+    while (c.filled - pos >= sizeof(gh_request_header))
+    {
+        gh_request_header h;
+        memcpy(&h, &c.in[pos], sizeof(h));
+
+        if (h.count > GH_MAX_BATCH)
+        {
+            put_response(c.out, GH_STATUS_TOO_LARGE, NULL, 0);
+            c.closing = true;
+            break;
+        }
+
+        size_t need = sizeof(h) + (size_t)h.count * 2 * sizeof(uint32_t);
+
+        //wait for the rest of the request
+        if (c.filled - pos < need)
+        {
+            if (need > c.in.size())
+                c.in.resize(need);
+            break;
+        }
+
+        handle_request(T, h, &c.in[pos + sizeof(h)], c.out, values);
+        requests++;
+
+        pos += need;
+    }
+
+    //every request answered from this read gets the latency of the last of their answers
+    c.appended += c.out.size() - out_before;
+
+    if (requests > 0)
+    {
+        answered_read a = {c.appended, read_time, requests};
+        c.timing.push_back(a);
+    }
+
+    //keep the unfinished request at the front of the buffer
+    if (pos > 0)
+    {
+        memmove(&c.in[0], &c.in[pos], c.filled - pos);
+        c.filled -= pos;
+    }
+
+    return true;
+}
+
+//==================================================================================================================================
+//write as much of the queued responses as the socket takes, returns false if the write failed
+bool flush_connection(connection &c)
+{
+    while (c.out_sent < c.out.size())
+    {
+        ssize_t sent = write(c.fd, &c.out[c.out_sent], c.out.size() - c.out_sent);
+
+        if (sent < 0 && errno == EINTR)
+            continue;
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return true;
+        if (sent <= 0)
+            return false;
+
+        c.out_sent += sent;
+        c.written += sent;
+    }
+
+    //record the reads whose answers are now all written
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    while (!c.timing.empty() && c.timing.front().end <= c.written)
+    {
+        unsigned long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now - c.timing.front().read_time).count();
+        latency_histogram[latency_bucket(ns)].fetch_add(c.timing.front().requests, std::memory_order_relaxed);
+        c.timing.pop_front();
+    }
+
+    c.out.clear();
+    c.out_sent = 0;
+
+    return true;
+}
+
+//==================================================================================================================================
+//reader thread. Polls the non-blocking connections handed to it by the accepting thread and serves whichever
+//is ready, so a client that keeps its connection open or stops reading its answers only holds up itself.
+void reader_thread(reader *R, const cut_tree *T)
+{
+    std::vector<connection> connections;
+    std::vector<struct pollfd> fds;
+    std::vector<uint32_t> values;
+
+    while (!stop_requested.load())
+    {
+        fds.clear();
+
+        struct pollfd wake = {R->wake_pipe[0], POLLIN, 0};
+        fds.push_back(wake);
+
+        for (size_t k = 0; k < connections.size(); k++)
+        {
+            connection &c = connections[k];
+            struct pollfd p = {c.fd, 0, 0};
+
+            //stop reading from a client that does not read its answers
+            if (!c.closing && c.out.size() - c.out_sent < OUTPUT_LIMIT)
+                p.events |= POLLIN;
+            if (c.out_sent < c.out.size())
+                p.events |= POLLOUT;
+
+            fds.push_back(p);
+        }
+
+        int ready = poll(fds.data(), fds.size(), 200);
+
+        if (ready < 0 && errno != EINTR)
+            break;
+        if (ready <= 0)
+            continue;
+
+        for (size_t k = 0; k + 1 < fds.size(); k++)
+        {
+            connection &c = connections[k];
+            short events = fds[k + 1].events;
+            short revents = fds[k + 1].revents;
+            bool alive = true;
+
+            if (revents == 0)
+                continue;
+
+            if ((events & POLLIN) && (revents & (POLLIN | POLLHUP | POLLERR)))
+                alive = read_connection(c, *T, values);
+
+            if (alive)
+                alive = flush_connection(c);
+
+            if (alive && c.closing && c.out_sent == c.out.size())
+                alive = false;
+
+            if (!alive)
+            {
+                close(c.fd);
+                c.fd = -1;
+            }
+        }
+
+        connections.erase(std::remove_if(connections.begin(), connections.end(), [](const connection &c) { return c.fd < 0; }), connections.end());
+
+        //take the new connections from the accepting thread
+        if (fds[0].revents & POLLIN)
+        {
+            char buf[64];
+
+            while (read(R->wake_pipe[0], buf, sizeof(buf)) > 0)
+                ;
+
+            std::lock_guard<std::mutex> lock(R->inbox_mutex);
+
+            for (size_t k = 0; k < R->inbox.size(); k++)
+            {
+                connection c;
+                c.fd = R->inbox[k];
+                c.in.resize(64 * 1024);
+                c.filled = 0;
+                c.out_sent = 0;
+                c.appended = 0;
+                c.written = 0;
+                c.closing = false;
+                connections.push_back(c);
+            }
+
+            R->inbox.clear();
+        }
+    }
+
+    for (size_t k = 0; k < connections.size(); k++)
+        close(connections[k].fd);
+}
+
+//==================================================================================================================================
+void handle_stop_signal(int)
+{
+    stop_requested.store(true);
+}
+
+//==================================================================================================================================
+//build a random graph the same way main does and turn its Gomory-Hu tree into a query tree
+bool generate_cut_tree(cut_tree &T, int num_nodes, int num_edges, int order_option)
+{
+    graph G;
+    std::vector<node> v(num_nodes);
+    node temp_node;
+    int i = 0;
+
+    random_simple_undirected_graph(G, num_nodes, num_edges);
+
+    forall_nodes(temp_node, G) v[i++] = temp_node;
+
+    list<edge> residual_edges;
+    G.make_bidirected(residual_edges);
+
+    node_array<int> color(G, 0);
+    int max_capacity = 50;
+
+    edge_array<int> capacity = set_capacities(G, max_capacity, residual_edges, 2);
+    edge_array<edge> rev_edge = save_rev_edge(capacity, G);
+    edge_array<int> new_capacity(G, 0);
+
+    create_gomory_hu_tree(color, v.data(), rev_edge, capacity, new_capacity, G, num_nodes, order_option);
+
+    return cut_tree_from_graph(T, v.data(), new_capacity, G, num_nodes);
+}
+
+//==================================================================================================================================
+void print_usage()
+{
+    std::cout << "usage: gh_server SOCKET_PATH (--load FILE | --generate NODES EDGES) [--order none|bfs|degree] [--save FILE] [--threads N]\n";
+}
+
+//==================================================================================================================================
+//Main function
+int main(int argc, char *argv[])
+{
+    const char *socket_path = NULL;
+    const char *load_path = NULL;
+    const char *save_path = NULL;
+    int num_nodes = 0, num_edges = 0;
+    int order_option = ORDER_NONE;
+    bool generate_given = false, order_given = false;
+    int num_threads = std::thread::hardware_concurrency();
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--load") == 0 && i + 1 < argc)
+            load_path = argv[++i];
+        else if (strcmp(argv[i], "--save") == 0 && i + 1 < argc)
+            save_path = argv[++i];
+        else if (strcmp(argv[i], "--generate") == 0 && i + 2 < argc)
+        {
+            num_nodes = atoi(argv[++i]);
+            num_edges = atoi(argv[++i]);
+            generate_given = true;
+        }
+        else if (strcmp(argv[i], "--order") == 0 && i + 1 < argc)
+        {
+            const char *name = argv[++i];
+            order_given = true;
+
+            if (strcmp(name, "none") == 0)
+                order_option = ORDER_NONE;
+            else if (strcmp(name, "bfs") == 0)
+                order_option = ORDER_BFS;
+            else if (strcmp(name, "degree") == 0)
+                order_option = ORDER_DEGREE;
+            else
+            {
+                print_usage();
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            num_threads = atoi(argv[++i]);
+        else if (socket_path == NULL && argv[i][0] != '-')
+            socket_path = argv[i];
+        else
+        {
+            print_usage();
+            return 1;
+        }
+    }
+
+    //a loaded tree is already built, --generate and --order would be silently ignored
+    if (socket_path == NULL || (load_path == NULL && num_nodes <= 0) || (load_path != NULL && (generate_given || order_given)))
+    {
+        print_usage();
+        return 1;
+    }
+
+    if (num_threads <= 0)
+        num_threads = 1;
+
+    //random_simple_undirected_graph needs at most n(n-1)/2 edges
+    if (generate_given && (num_nodes > MAX_TREE_NODES || num_edges < 0 || (long long)num_edges > (long long)num_nodes * (num_nodes - 1) / 2))
+    {
+        std::cout << "\033[1;31m[-]--generate takes at most " << MAX_TREE_NODES << " nodes and n(n-1)/2 edges!\033[0m\n";
+        return 1;
+    }
+
+    //Load or build the cut tree---------------------------------------------------------------------------
+    cut_tree T;
+    clock_t begin = clock();
+
+    if (load_path != NULL ? !load_cut_tree(T, load_path) : !generate_cut_tree(T, num_nodes, num_edges, order_option))
+    {
+        std::cout << "\033[1;31m[-]Could not build the cut tree!\033[0m\n";
+        return 1;
+    }
+
+    clock_t end = clock();
+    std::cout << "Cut tree with " << T.num_nodes << " nodes ready in " << double(end - begin) / CLOCKS_PER_SEC << "s.\n";
+
+    if (save_path != NULL && !save_cut_tree(T, save_path))
+        std::cout << "\033[1;31m[-]Could not save the cut tree to " << save_path << "\033[0m\n";
+
+    //Open the socket---------------------------------------------------------------------------------------
+    struct sockaddr_un addr;
+
+    if (strlen(socket_path) >= sizeof(addr.sun_path))
+    {
+        std::cout << "\033[1;31m[-]Socket path is too long!\033[0m\n";
+        return 1;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, socket_path);
+
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(socket_path);
+
+    if (listen_fd < 0 || !set_nonblocking(listen_fd) || bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(listen_fd, 128) < 0)
+    {
+        std::cout << "\033[1;31m[-]Could not listen on " << socket_path << ": " << strerror(errno) << "\033[0m\n";
+        return 1;
+    }
+
+    //only the accepting thread gets SIGINT/SIGTERM so its poll() is the call that is interrupted
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = handle_stop_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    sigset_t stop_signals, old_mask;
+    sigemptyset(&stop_signals);
+    sigaddset(&stop_signals, SIGINT);
+    sigaddset(&stop_signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &stop_signals, &old_mask);
+
+    std::vector<reader> readers(num_threads);
+
+    for (int i = 0; i < num_threads; i++)
+    {
+        if (pipe(readers[i].wake_pipe) < 0 || !set_nonblocking(readers[i].wake_pipe[0]) || !set_nonblocking(readers[i].wake_pipe[1]))
+        {
+            std::cout << "\033[1;31m[-]Could not create the reader threads!\033[0m\n";
+            return 1;
+        }
+
+        readers[i].thread = std::thread(reader_thread, &readers[i], &T);
+    }
+
+    pthread_sigmask(SIG_SETMASK, &old_mask, NULL);
+
+    std::cout << "Listening on " << socket_path << " with " << num_threads << " reader threads.\n";
+
+    //Accept loop-------------------------------------------------------------------------------------------
+    int next_reader = 0;
+
+    while (!stop_requested.load())
+    {
+        //poll with a timeout so a signal that arrives between the check above and accept() is still seen
+        struct pollfd p = {listen_fd, POLLIN, 0};
+        int ready = poll(&p, 1, 200);
+
+        if (ready < 0 && errno != EINTR)
+        {
+            std::cout << "\033[1;31m[-]poll failed: " << strerror(errno) << "\033[0m\n";
+            break;
+        }
+        if (ready <= 0)
+            continue;
+
+        int fd = accept(listen_fd, NULL, NULL);
+
+        if (fd < 0)
+        {
+            //the client may have gone away between poll and accept
+            if (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK || errno == ECONNABORTED)
+                continue;
+            std::cout << "\033[1;31m[-]accept failed: " << strerror(errno) << "\033[0m\n";
+            break;
+        }
+
+        if (!set_nonblocking(fd))
+        {
+            close(fd);
+            continue;
+        }
+
+        //hand the connection to the readers in turn
+        reader &R = readers[next_reader];
+        next_reader = (next_reader + 1) % num_threads;
+
+        {
+            std::lock_guard<std::mutex> lock(R.inbox_mutex);
+            R.inbox.push_back(fd);
+        }
+
+        //a full pipe already has a wake-up pending
+        char wake = 1;
+        if (write(R.wake_pipe[1], &wake, 1) < 0 && errno != EAGAIN)
+            std::cout << "\033[1;31m[-]Could not wake a reader thread!\033[0m\n";
+    }
+
+    //Shut down---------------------------------------------------------------------------------------------
+    stop_requested.store(true);
+
+    for (int i = 0; i < num_threads; i++)
+    {
+        readers[i].thread.join();
+
+        for (size_t k = 0; k < readers[i].inbox.size(); k++)
+            close(readers[i].inbox[k]);
+
+        close(readers[i].wake_pipe[0]);
+        close(readers[i].wake_pipe[1]);
+    }
+
+    close(listen_fd);
+    unlink(socket_path);
+
+    unsigned long long total;
+    unsigned long long p50 = latency_percentile(0.50, total);
+    unsigned long long p99 = latency_percentile(0.99, total);
+
+    std::cout << "\nRequests served: " << total << "\np50 latency: " << p50 << "ns\np99 latency: " << p99 << "ns\n";
+
+    return 0;
+}
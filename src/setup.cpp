@@ -13,10 +13,14 @@
 #include <LEDA/graph/node_list.h>
 #include <LEDA/system/basic.h>
 #include <iostream>
+#include <vector>
+#include <algorithm>
 #include <LEDA/graph/templates/max_flow.h>
 #include <LEDA/numbers/integer.h>
 #include <LEDA/graph/min_cut.h>
 
+#include "setup.h"
+
 using namespace leda;
 
 //==================================================================================================================================
@@ -241,7 +245,7 @@ edge_array<int> set_capacities(const graph &G, int max_capacity, list<edge> rev_
 
 //==================================================================================================================================
 //Check if the results are the same
-void all_pair_mincut_checker(int num_nodes, int calculated_mincuts[], integer ledas_mincuts[])
+int all_pair_mincut_checker(int num_nodes, int calculated_mincuts[], integer ledas_mincuts[])
 {
 
     int wrong_calculations = 0;
@@ -264,6 +268,8 @@ void all_pair_mincut_checker(int num_nodes, int calculated_mincuts[], integer le
     }
 
     std::cout << "\n========================\nRight Calculations: " << right_calculations << "\nWrong Calculations: " << wrong_calculations;
+
+    return wrong_calculations;
 }
 
 //==================================================================================================================================
@@ -328,34 +334,210 @@ void find_mincut_for_all_pairs_leda(int num_nodes, integer max_flow_leda[], node
 }
 
 //==================================================================================================================================
-//Gomory Hu tree construction
-edge_array<edge> create_gomory_hu_tree(node_array<int> &visited, node v[], edge_array<edge> &rev_edge, edge_array<int> &capacity, edge_array<int> &new_capacity, graph &G, int num_nodes)
+//Compute the memory layout of the reordered graph, order[k] is the index in v[] of the node that gets the new
+//index k. ORDER_BFS is reverse Cuthill-McKee, which keeps the neighbours of a node close to it
+void compute_node_order(std::vector<int> &order, node v[], const graph &G, int num_nodes, int order_option)
 {
+    int i, k;
+    std::vector<int> degree(num_nodes);
+    node_array<int> index(G, -1);
 
-    int i, j, s, t, pos, min_cut;
+    order.resize(num_nodes);
 
-    node source,
-        sink;
+    for (i = 0; i < num_nodes; i++)
+    {
+        order[i] = i;
+        index[v[i]] = i;
+        degree[i] = G.outdeg(v[i]);
+    }
+
+    if (order_option == ORDER_DEGREE)
+    {
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return degree[a] > degree[b]; });
+    }
+    else if (order_option == ORDER_BFS)
+    {
+        //candidate start nodes, lowest degree first. Every component starts from a peripheral node
+        std::vector<int> by_degree(order);
+        std::vector<bool> placed(num_nodes, false);
+
+        std::stable_sort(by_degree.begin(), by_degree.end(), [&](int a, int b) { return degree[a] < degree[b]; });
+
+        int head = 0, tail = 0;
+        std::vector<int> neighbours;
+
+        for (k = 0; k < num_nodes; k++)
+        {
+            if (placed[by_degree[k]])
+                continue;
+
+            order[tail++] = by_degree[k];
+            placed[by_degree[k]] = true;
+
+            while (head < tail)
+            {
+                node u = v[order[head++]];
+                edge e;
+
+                neighbours.clear();
 
-    int p[num_nodes], f1[num_nodes];
-    int cut_tree_capacities[num_nodes][num_nodes];
+                forall_adj_edges(e, u)
+                {
+                    int j = index[G.target(e)];
+
+                    if (j >= 0 && !placed[j])
+                    {
+                        placed[j] = true;
+                        neighbours.push_back(j);
+                    }
+                }
+
+                //Cuthill-McKee visits the neighbours by increasing degree
+                std::stable_sort(neighbours.begin(), neighbours.end(), [&](int a, int b) { return degree[a] < degree[b]; });
+
+                for (i = 0; i < (int)neighbours.size(); i++)
+                    order[tail++] = neighbours[i];
+            }
+        }
+
+        std::reverse(order.begin(), order.end());
+    }
+}
+
+//==================================================================================================================================
+//Compute the order in which Gusfield's algorithm picks its sources, source[k] is the index in v[] of the k-th
+//node and source[0] is the first sink. The capacity leaving a node bounds every cut that separates it, so
+//nodes with the most capacity go first: the early flows run between hubs and split the graph in large parts
+//instead of cutting off leaves one at a time
+void compute_source_order(std::vector<int> &source, node v[], edge_array<int> &capacity, int num_nodes, int order_option)
+{
+    int i;
+    std::vector<long long> weight(num_nodes, 0);
+
+    source.resize(num_nodes);
+
+    for (i = 0; i < num_nodes; i++)
+        source[i] = i;
+
+    if (order_option == ORDER_NONE)
+        return;
 
     for (i = 0; i < num_nodes; i++)
     {
-        p[i] = 0;
-        f1[i] = 0;
-        for (j = 0; j < num_nodes; j++)
+        edge e;
+
+        forall_adj_edges(e, v[i]) weight[i] += capacity[e];
+    }
+
+    std::stable_sort(source.begin(), source.end(), [&](int a, int b) { return weight[a] > weight[b]; });
+}
+
+//==================================================================================================================================
+//Copy G into H so that node k of H is v[order[k]] and the arcs of every node are created together, sorted by
+//their target. LEDA hands out node and edge memory in creation order, so the BFS in find_max_flow scans
+//the adjacency lists and the node/edge arrays of H mostly in order.
+void build_reordered_graph(graph &H, std::vector<node> &w, edge_array<edge> &H_rev_edge, edge_array<int> &H_capacity, const std::vector<int> &order, node v[], edge_array<edge> &rev_edge, edge_array<int> &capacity, const graph &G, int num_nodes)
+{
+    int k;
+    node_array<int> rank(G, -1);
+    edge_array<edge> image(G, nil);
+    std::vector<edge> arcs;
+    edge e;
+
+    w.resize(num_nodes);
+
+    for (k = 0; k < num_nodes; k++)
+    {
+        rank[v[order[k]]] = k;
+        w[k] = H.new_node();
+    }
+
+    for (k = 0; k < num_nodes; k++)
+    {
+        node u = v[order[k]];
+
+        //arcs into nodes that are not in v[] are left out, as in compute_node_order
+        arcs.clear();
+        forall_adj_edges(e, u)
         {
-            cut_tree_capacities[i][j] = 0;
+            if (rank[G.target(e)] >= 0)
+                arcs.push_back(e);
         }
+
+        std::sort(arcs.begin(), arcs.end(), [&](edge a, edge b) { return rank[G.target(a)] < rank[G.target(b)]; });
+
+        for (int i = 0; i < (int)arcs.size(); i++)
+            image[arcs[i]] = H.new_edge(w[k], w[rank[G.target(arcs[i])]]);
+    }
+
+    H_capacity.init(H, 0);
+    H_rev_edge.init(H, nil);
+
+    forall_edges(e, G)
+    {
+        if (image[e] == nil)
+            continue;
+
+        H_capacity[image[e]] = capacity[e];
+
+        if (rev_edge[e] != nil)
+            H_rev_edge[image[e]] = image[rev_edge[e]];
     }
+}
+
+//==================================================================================================================================
+//Gomory Hu tree construction
+edge_array<edge> create_gomory_hu_tree(node_array<int> &visited, node v[], edge_array<edge> &rev_edge, edge_array<int> &capacity, edge_array<int> &new_capacity, graph &G, int num_nodes, int order_option)
+{
+
+    int i, s, t, pos, min_cut;
+
+    node source,
+        sink;
+
+    //kept on the heap, a num_nodes x num_nodes matrix on the stack overflows it at about 1400 nodes.
+    //cut_tree_capacities[i * num_nodes + j] is the capacity of tree edge i-j
+    std::vector<int> p(num_nodes, 0), f1(num_nodes, 0);
+    std::vector<int> cut_tree_capacities((size_t)num_nodes * num_nodes, 0);
+
+    //run the flows on a reordered copy of G unless no order was asked for. The layout of the copy and the
+    //order of the sources are chosen separately: index k below is the node sources[k] of v[], found in the
+    //copy at w[rank[sources[k]]]
+    std::vector<int> order, sources;
+    compute_node_order(order, v, G, num_nodes, order_option);
+    compute_source_order(sources, v, capacity, num_nodes, order_option);
+
+    bool reordered = (order_option != ORDER_NONE);
+
+    graph H;
+    std::vector<node> w;
+    edge_array<edge> H_rev_edge;
+    edge_array<int> H_capacity;
+
+    if (reordered)
+        build_reordered_graph(H, w, H_rev_edge, H_capacity, order, v, rev_edge, capacity, G, num_nodes);
+
+    node_array<int> H_visited(H, 0);
+
+    const graph &flow_G = reordered ? H : G;
+    std::vector<int> rank(num_nodes);
+    std::vector<node> flow_v(num_nodes);
+
+    for (i = 0; i < num_nodes; i++)
+        rank[order[i]] = i;
+
+    for (i = 0; i < num_nodes; i++)
+        flow_v[i] = reordered ? w[rank[sources[i]]] : v[sources[i]];
+    node_array<int> &flow_visited = reordered ? H_visited : visited;
+    edge_array<edge> &flow_rev_edge = reordered ? H_rev_edge : rev_edge;
+    edge_array<int> &flow_capacity = reordered ? H_capacity : capacity;
 
     //////////////////////////////////////////////////////////
     for (s = 1; s < num_nodes; s++)
     {
         t = p[s];
 
-        min_cut = find_max_flow(visited, s, t, v, rev_edge, capacity, G);
+        min_cut = find_max_flow(flow_visited, s, t, flow_v.data(), flow_rev_edge, flow_capacity, flow_G);
 
         f1[s] = min_cut;
 
@@ -363,14 +545,14 @@ edge_array<edge> create_gomory_hu_tree(node_array<int> &visited, node v[], edge_
         for (i = 0; i < num_nodes; i++)
         {
 
-            if (i != s && p[i] == t && visited[v[i]] == 1)
+            if (i != s && p[i] == t && flow_visited[flow_v[i]] == 1)
             {
                 p[i] = s;
             }
         }
 
         //node with index p[t] belongs to the set of nodes on the s side
-        if (visited[v[p[t]]] == 1)
+        if (flow_visited[flow_v[p[t]]] == 1)
         {
             p[s] = p[t];
             p[t] = s;
@@ -378,14 +560,14 @@ edge_array<edge> create_gomory_hu_tree(node_array<int> &visited, node v[], edge_
             f1[t] = min_cut;
         }
 
-        //Store the final cut tree when s is the last node of the input graph.
+        //Store the final cut tree when s is the last node of the input graph, mapped back to the indices of v[].
         if (s == num_nodes - 1)
         {
             for (i = 1; i <= s; i++)
             {
 
-                cut_tree_capacities[i][p[i]] = f1[i];
-                cut_tree_capacities[p[i]][i] = f1[i];
+                cut_tree_capacities[(size_t)sources[i] * num_nodes + sources[p[i]]] = f1[i];
+                cut_tree_capacities[(size_t)sources[p[i]] * num_nodes + sources[i]] = f1[i];
             }
         }
     }
@@ -401,7 +583,7 @@ edge_array<edge> create_gomory_hu_tree(node_array<int> &visited, node v[], edge_
             if (node_i == node_j)
                 continue;
 
-            if (std::max(cut_tree_capacities[node_i][node_j], cut_tree_capacities[node_j][node_i]) > 0)
+            if (std::max(cut_tree_capacities[(size_t)node_i * num_nodes + node_j], cut_tree_capacities[(size_t)node_j * num_nodes + node_i]) > 0)
             {
                 G.new_edge(v[node_i], v[node_j]);
             }
@@ -425,7 +607,7 @@ edge_array<edge> create_gomory_hu_tree(node_array<int> &visited, node v[], edge_
     {
         node i = G.source(e1);
         node j = G.target(e1);
-        new_capacity[e1] = std::max(cut_tree_capacities[node_id[i]][node_id[j]], cut_tree_capacities[node_id[j]][node_id[i]]);
+        new_capacity[e1] = std::max(cut_tree_capacities[(size_t)node_id[i] * num_nodes + node_id[j]], cut_tree_capacities[(size_t)node_id[j] * num_nodes + node_id[i]]);
     }
 
     edge_array<edge> new_rev_edge;
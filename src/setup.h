@@ -13,6 +13,7 @@
 #include <LEDA/graph/node_list.h>
 #include <LEDA/system/basic.h>
 #include <iostream>
+#include <vector>
 #include <LEDA/graph/templates/max_flow.h>
 #include <LEDA/numbers/integer.h>
 #include <LEDA/graph/min_cut.h>
@@ -38,11 +39,28 @@ edge_array<edge> save_rev_edge(edge_array<int> &capacity, const graph &G);
 //Helper function for adding the desired capacities values
 edge_array<int> set_capacities(const graph &G, int max_capacity, list<edge> residual_edges, int option);
 //==================================================================================================================================
+//node orders for the Gomory Hu tree construction. Both reorderings pick the Gusfield sources by decreasing capacity
+const int ORDER_NONE = 0;   //use v[] as given for the layout and the sources
+const int ORDER_BFS = 1;    //reverse Cuthill-McKee layout
+const int ORDER_DEGREE = 2; //layout with the highest degree nodes first
+//==================================================================================================================================
+//compute the memory layout, order[k] is the index in v[] of the node that gets the new index k
+void compute_node_order(std::vector<int> &order, node v[], const graph &G, int num_nodes, int order_option);
+//==================================================================================================================================
+//compute the Gusfield source order, source[k] is the index in v[] of the k-th source
+void compute_source_order(std::vector<int> &source, node v[], edge_array<int> &capacity, int num_nodes, int order_option);
+//==================================================================================================================================
+//copy G into H with nodes and arcs laid out in the given order
+void build_reordered_graph(graph &H, std::vector<node> &w, edge_array<edge> &H_rev_edge, edge_array<int> &H_capacity, const std::vector<int> &order, node v[], edge_array<edge> &rev_edge, edge_array<int> &capacity, const graph &G, int num_nodes);
+//==================================================================================================================================
+//largest graph create_gomory_hu_tree is meant for, it keeps a num_nodes x num_nodes int matrix (400MB at this size)
+const int MAX_TREE_NODES = 10000;
+//==================================================================================================================================
 //Gomory Hu tree construction
-edge_array<edge> create_gomory_hu_tree(node_array<int> &color, node v[], edge_array<edge> &rev_edge, edge_array<int> &capacity, edge_array<int> &new_capacity, graph &G, int num_nodes);
+edge_array<edge> create_gomory_hu_tree(node_array<int> &color, node v[], edge_array<edge> &rev_edge, edge_array<int> &capacity, edge_array<int> &new_capacity, graph &G, int num_nodes, int order_option);
 //==================================================================================================================================
-//check if calculated max flow for all pairs are the same with the leda's results
-void all_pair_mincut_checker(int num_nodes, int calculated_mincuts[], integer ledas_mincuts[]);
+//check if calculated max flow for all pairs are the same with the leda's results, returns the number of wrong ones
+int all_pair_mincut_checker(int num_nodes, int calculated_mincuts[], integer ledas_mincuts[]);
 //==================================================================================================================================
 void find_mincut_for_all_pairs(int num_nodes, int max_flow_mine[], node_array<int> &color, node v[], edge_array<edge> &rev_edge, edge_array<int> &capacity, const graph &G);
 //==================================================================================================================================